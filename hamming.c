@@ -167,6 +167,28 @@ const unsigned char hammingPackedDecodeValues[CODE_VALUES] =
     0x81, 0xAF, 0xCF, 0xFF      /* 0x78 to 0x7F */
 };
 
+/* table of syndromes (H x code) for every code */
+/* hammingSyndromes[code] = syndrome of code */
+const unsigned char hammingSyndromes[CODE_VALUES] =
+{
+    0x00, 0x07, 0x06, 0x01, 0x05, 0x02, 0x03, 0x04,     /* 0x00 to 0x07 */
+    0x03, 0x04, 0x05, 0x02, 0x06, 0x01, 0x00, 0x07,     /* 0x08 to 0x0F */
+    0x01, 0x06, 0x07, 0x00, 0x04, 0x03, 0x02, 0x05,     /* 0x10 to 0x17 */
+    0x02, 0x05, 0x04, 0x03, 0x07, 0x00, 0x01, 0x06,     /* 0x18 to 0x1F */
+    0x02, 0x05, 0x04, 0x03, 0x07, 0x00, 0x01, 0x06,     /* 0x20 to 0x27 */
+    0x01, 0x06, 0x07, 0x00, 0x04, 0x03, 0x02, 0x05,     /* 0x28 to 0x2F */
+    0x03, 0x04, 0x05, 0x02, 0x06, 0x01, 0x00, 0x07,     /* 0x30 to 0x37 */
+    0x00, 0x07, 0x06, 0x01, 0x05, 0x02, 0x03, 0x04,     /* 0x38 to 0x3F */
+    0x04, 0x03, 0x02, 0x05, 0x01, 0x06, 0x07, 0x00,     /* 0x40 to 0x47 */
+    0x07, 0x00, 0x01, 0x06, 0x02, 0x05, 0x04, 0x03,     /* 0x48 to 0x4F */
+    0x05, 0x02, 0x03, 0x04, 0x00, 0x07, 0x06, 0x01,     /* 0x50 to 0x57 */
+    0x06, 0x01, 0x00, 0x07, 0x03, 0x04, 0x05, 0x02,     /* 0x58 to 0x5F */
+    0x06, 0x01, 0x00, 0x07, 0x03, 0x04, 0x05, 0x02,     /* 0x60 to 0x67 */
+    0x05, 0x02, 0x03, 0x04, 0x00, 0x07, 0x06, 0x01,     /* 0x68 to 0x6F */
+    0x07, 0x00, 0x01, 0x06, 0x02, 0x05, 0x04, 0x03,     /* 0x70 to 0x77 */
+    0x04, 0x03, 0x02, 0x05, 0x01, 0x06, 0x07, 0x00      /* 0x78 to 0x7F */
+};
+
 /***************************************************************************
 *                                FUNCTIONS
 ***************************************************************************/
@@ -248,21 +270,17 @@ unsigned char HammingTableEncode(unsigned char data)
 }
 
 /***************************************************************************
-*   Function   : HammingMatrixDecode
-*   Description: This function uses the matrix H (above) to determine the
-*                value encoded by a CODE_BITS long code.  H is a parity
-*                check matrix based on the encoding matrix G.  The result
-*                of multiplying the code by H is called the syndrome.  If
-*                there are no errors in the code, the syndrome will be a 0
-*                vector.  If the syndrome is not 0, it will match a column
-*                in H.  The column it matches is likely the errored bit.
-*                Toggle the errored bit and the resulting code is the
-*                nearest matching correct code.
-*   Parameters : code - CODE_BITS long series of code bits to decode.
+*   Function   : HammingMatrixSyndrome
+*   Description: This function uses the matrix H (above) to compute the
+*                syndrome of a CODE_BITS long code.  H is a parity check
+*                matrix based on the encoding matrix G.  The syndrome is
+*                the result of multiplying the code by H.  If there are no
+*                errors in the code, the syndrome will be a 0 vector.
+*   Parameters : code - CODE_BITS long series of code bits.
 *   Effects    : None
-*   Returned   : Nearest value to encoded data
+*   Returned   : PARITY_BITS long syndrome of code
 ***************************************************************************/
-unsigned char HammingMatrixDecode(unsigned char code)
+unsigned char HammingMatrixSyndrome(unsigned char code)
 {
     unsigned char i, syndromeVal;
     unsigned char syndromeColBits;  /* sum of bits is bit in syndrome */
@@ -283,6 +301,30 @@ unsigned char HammingMatrixDecode(unsigned char code)
         }
     }
 
+    return syndromeVal;
+}
+
+/***************************************************************************
+*   Function   : HammingMatrixDecode
+*   Description: This function uses the matrix H (above) to determine the
+*                value encoded by a CODE_BITS long code.  H is a parity
+*                check matrix based on the encoding matrix G.  The result
+*                of multiplying the code by H is called the syndrome.  If
+*                there are no errors in the code, the syndrome will be a 0
+*                vector.  If the syndrome is not 0, it will match a column
+*                in H.  The column it matches is likely the errored bit.
+*                Toggle the errored bit and the resulting code is the
+*                nearest matching correct code.
+*   Parameters : code - CODE_BITS long series of code bits to decode.
+*   Effects    : None
+*   Returned   : Nearest value to encoded data
+***************************************************************************/
+unsigned char HammingMatrixDecode(unsigned char code)
+{
+    unsigned char syndromeVal;
+
+    syndromeVal = HammingMatrixSyndrome(code);
+
     /* return the data corrected for error */
     return ((code ^ syndromeMask[syndromeVal]) & (0xFF >> DATA_BITS));
 }
@@ -338,3 +380,340 @@ unsigned char HammingPackedTableDecode(unsigned char code)
     return decoded;
 }
 
+/***************************************************************************
+*   Function   : HammingEncodeBuffer
+*   Description: This function uses the lookup table to encode a buffer of
+*                bytes into a buffer of Hamming codes.  Each byte is split
+*                into two DATA_BITS long values, the MS nibble first, and
+*                each value is encoded into its own code.
+*   Parameters : codes - buffer of 2 * len bytes receiving the codes.
+*                data - buffer of len bytes to encode.
+*                len - number of bytes to encode.
+*   Effects    : 2 * len codes are written to codes.
+*   Returned   : None
+***************************************************************************/
+void HammingEncodeBuffer(unsigned char *codes, const unsigned char *data,
+    size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        codes[0] = hammingCodes[data[i] >> DATA_BITS];
+        codes[1] = hammingCodes[data[i] & (0xFF >> DATA_BITS)];
+        codes += 2;
+    }
+}
+
+/***************************************************************************
+*   Function   : HammingDecodeBuffer
+*   Description: This function uses the lookup table to decode a buffer of
+*                Hamming codes produced by HammingEncodeBuffer back into a
+*                buffer of bytes.  Each byte is built from two codes, the
+*                MS nibble first.  Single bit errors in each code are
+*                corrected.
+*   Parameters : data - buffer of len bytes receiving decoded data.
+*                codes - buffer of 2 * len codes to decode.
+*                len - number of bytes to decode.
+*   Effects    : len decoded bytes are written to data.
+*   Returned   : None
+***************************************************************************/
+void HammingDecodeBuffer(unsigned char *data, const unsigned char *codes,
+    size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        data[i] = (hammingDecodeValues[codes[0] & (CODE_VALUES - 1)] <<
+            DATA_BITS) | hammingDecodeValues[codes[1] & (CODE_VALUES - 1)];
+        codes += 2;
+    }
+}
+
+/***************************************************************************
+*   Function   : HammingStreamInit
+*   Description: This function prepares a stream context for a new stream
+*                of packed codes.  The same context type is used for
+*                encoding and decoding, but a context must only be used
+*                for one of them at a time.
+*   Parameters : stream - pointer to stream context.
+*   Effects    : stream is emptied.
+*   Returned   : None
+***************************************************************************/
+void HammingStreamInit(hamming_stream_t *stream)
+{
+    stream->bits = 0;
+    stream->bitCount = 0;
+    stream->nibble = 0;
+    stream->haveNibble = 0;
+}
+
+/***************************************************************************
+*   Function   : HammingStreamEncodeUpdate
+*   Description: This function uses the lookup table to encode a chunk of
+*                bytes and pack the codes into a stream.  Each byte is
+*                encoded as two CODE_BITS long codes, the MS nibble first,
+*                and codes are packed MSB first with no padding between
+*                them.  Bits that don't fill a byte are kept in the stream
+*                context for the next call, so chunks may be any length.
+*   Parameters : stream - pointer to stream context.
+*                packed - buffer receiving packed codes.  It must hold
+*                         HAMMING_STREAM_ENCODE_SIZE(len) bytes.
+*                data - chunk of bytes to encode.
+*                len - number of bytes in data.
+*   Effects    : Packed codes are written to packed and stream is updated.
+*   Returned   : Number of bytes written to packed.
+***************************************************************************/
+size_t HammingStreamEncodeUpdate(hamming_stream_t *stream,
+    unsigned char *packed, const unsigned char *data, size_t len)
+{
+    size_t i, written;
+    unsigned long bits;
+    unsigned char bitCount;
+
+    bits = stream->bits;
+    bitCount = stream->bitCount;
+    written = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        /* append both codes, at most CHAR_BIT - 1 bits are waiting */
+        bits = (bits << (2 * CODE_BITS)) |
+            (hammingCodes[data[i] >> DATA_BITS] << CODE_BITS) |
+            hammingCodes[data[i] & (0xFF >> DATA_BITS)];
+        bitCount += 2 * CODE_BITS;
+
+        while (bitCount >= CHAR_BIT)
+        {
+            bitCount -= CHAR_BIT;
+            packed[written++] = (unsigned char)(bits >> bitCount);
+        }
+    }
+
+    stream->bits = bits & ((1UL << bitCount) - 1);
+    stream->bitCount = bitCount;
+
+    return written;
+}
+
+/***************************************************************************
+*   Function   : HammingStreamEncodeFinish
+*   Description: This function ends a stream of packed codes by writing
+*                any bits left in the stream context, padded with 0s to
+*                fill a byte.  The padding is always shorter than a code.
+*   Parameters : stream - pointer to stream context.
+*                packed - buffer receiving the last byte of packed codes.
+*   Effects    : Up to one byte is written to packed and stream is
+*                emptied for reuse.
+*   Returned   : Number of bytes written to packed.
+***************************************************************************/
+size_t HammingStreamEncodeFinish(hamming_stream_t *stream,
+    unsigned char *packed)
+{
+    size_t written;
+
+    written = 0;
+
+    if (stream->bitCount)
+    {
+        packed[written++] =
+            (unsigned char)(stream->bits << (CHAR_BIT - stream->bitCount));
+    }
+
+    HammingStreamInit(stream);
+
+    return written;
+}
+
+/***************************************************************************
+*   Function   : HammingStreamDecodeUpdate
+*   Description: This function uses the lookup table to decode a chunk of
+*                a stream produced by HammingStreamEncodeUpdate.  Single
+*                bit errors in each code are corrected.  Bits of a partial
+*                code and the MS nibble of a partial byte are kept in the
+*                stream context for the next call, so chunks may be any
+*                length.
+*   Parameters : stream - pointer to stream context.
+*                data - buffer receiving decoded bytes.  It must hold
+*                       HAMMING_STREAM_DECODE_SIZE(len) bytes.
+*                packed - chunk of packed codes to decode.
+*                len - number of bytes in packed.
+*   Effects    : Decoded bytes are written to data and stream is updated.
+*   Returned   : Number of bytes written to data.
+***************************************************************************/
+size_t HammingStreamDecodeUpdate(hamming_stream_t *stream,
+    unsigned char *data, const unsigned char *packed, size_t len)
+{
+    size_t i, written;
+    unsigned long bits;
+    unsigned char bitCount, nibble, haveNibble;
+
+    bits = stream->bits;
+    bitCount = stream->bitCount;
+    nibble = stream->nibble;
+    haveNibble = stream->haveNibble;
+    written = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        /* at most CODE_BITS - 1 bits are waiting */
+        bits = (bits << CHAR_BIT) | packed[i];
+        bitCount += CHAR_BIT;
+
+        while (bitCount >= CODE_BITS)
+        {
+            bitCount -= CODE_BITS;
+
+            if (haveNibble)
+            {
+                data[written++] = (nibble << DATA_BITS) |
+                    hammingDecodeValues[(bits >> bitCount) &
+                    (CODE_VALUES - 1)];
+                haveNibble = 0;
+            }
+            else
+            {
+                nibble = hammingDecodeValues[(bits >> bitCount) &
+                    (CODE_VALUES - 1)];
+                haveNibble = 1;
+            }
+        }
+    }
+
+    stream->bits = bits & ((1UL << bitCount) - 1);
+    stream->bitCount = bitCount;
+    stream->nibble = nibble;
+    stream->haveNibble = haveNibble;
+
+    return written;
+}
+
+/***************************************************************************
+*   Function   : HammingStreamDecodeFinish
+*   Description: This function ends the decoding of a stream of packed
+*                codes.  Bits left in the stream context are the padding
+*                written by HammingStreamEncodeFinish and are discarded.
+*                A decoded MS nibble without its LS nibble means that the
+*                stream was cut short.
+*   Parameters : stream - pointer to stream context.
+*   Effects    : stream is emptied for reuse.
+*   Returned   : 1 if the stream ended on a whole byte, otherwise 0.
+***************************************************************************/
+int HammingStreamDecodeFinish(hamming_stream_t *stream)
+{
+    int complete;
+
+    complete = !stream->haveNibble;
+    HammingStreamInit(stream);
+
+    return complete;
+}
+
+/***************************************************************************
+*   Function   : HammingErasureDecode
+*   Description: This function determines the value encoded by a
+*                CODE_BITS long code when the receiver knows which code
+*                bits are unreliable (erased).  The syndrome is linear, so
+*                the erased bits must be filled with a pattern whose
+*                syndrome matches the syndrome of the received code.  With
+*                no more than MAX_ERASURES erasures and no other errors,
+*                exactly one such pattern exists.  Codes without erasures
+*                are decoded with the lookup table, so a single bit error
+*                is still corrected.
+*   Parameters : code - CODE_BITS long series of code bits to decode.
+*                erasures - mask with a 1 in each erased bit position of
+*                           code.  The value of erased bits is ignored.
+*                data - pointer to where the decoded value is written.
+*   Effects    : The decoded value is written to data.  If the erasures
+*                can't be resolved, the nearest value to code is written.
+*   Returned   : 1 if the erasures were resolved, otherwise 0.
+***************************************************************************/
+int HammingErasureDecode(unsigned char code, unsigned char erasures,
+    unsigned char *data)
+{
+    unsigned char syndromeVal, fill, extra;
+
+    code &= (CODE_VALUES - 1);
+    erasures &= (CODE_VALUES - 1);
+
+    if (0 == erasures)
+    {
+        /* nothing erased, correct any single bit error */
+        *data = hammingDecodeValues[code];
+        return 1;
+    }
+
+    /* clear the two lowest erasures, anything left is too many */
+    extra = erasures & (erasures - 1);
+    extra &= (extra - 1);
+
+    if (0 == extra)
+    {
+        syndromeVal = hammingSyndromes[code];
+
+        /* try every fill of the erased bits, starting with no change */
+        fill = 0;
+
+        do
+        {
+            if (hammingSyndromes[fill] == syndromeVal)
+            {
+                *data = (code ^ fill) & (0xFF >> DATA_BITS);
+                return 1;
+            }
+
+            /* next subset of erasures */
+            fill = (fill - erasures) & erasures;
+        } while (0 != fill);
+    }
+
+    /* too many erasures, or an error outside of them */
+    *data = hammingDecodeValues[code];
+    return 0;
+}
+
+/***************************************************************************
+*   Function   : HammingErasureDecodeBuffer
+*   Description: This function decodes a buffer of codes, each with a
+*                matching erasure mask, into a buffer of bytes.  Each byte
+*                is built from two codes, the MS nibble first.  Pairs of
+*                codes without erasures go straight through the lookup
+*                table.
+*   Parameters : data - buffer of len bytes receiving decoded data.
+*                codes - buffer of 2 * len codes to decode.
+*                erasures - buffer of 2 * len erasure masks, one for each
+*                           code (see HammingErasureDecode).
+*                len - number of bytes to decode.
+*   Effects    : len decoded bytes are written to data.
+*   Returned   : Number of codes whose erasures couldn't be resolved.
+***************************************************************************/
+size_t HammingErasureDecodeBuffer(unsigned char *data,
+    const unsigned char *codes, const unsigned char *erasures, size_t len)
+{
+    size_t i, unresolved;
+    unsigned char msn, lsn;
+
+    unresolved = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (0 == (erasures[0] | erasures[1]))
+        {
+            /* common case, no erasures in either code */
+            msn = hammingDecodeValues[codes[0] & (CODE_VALUES - 1)];
+            lsn = hammingDecodeValues[codes[1] & (CODE_VALUES - 1)];
+        }
+        else
+        {
+            unresolved += !HammingErasureDecode(codes[0], erasures[0], &msn);
+            unresolved += !HammingErasureDecode(codes[1], erasures[1], &lsn);
+        }
+
+        data[i] = (msn << DATA_BITS) | lsn;
+        codes += 2;
+        erasures += 2;
+    }
+
+    return unresolved;
+}
@@ -48,6 +48,7 @@
 *                             INCLUDED FILES
 ***************************************************************************/
 #include <limits.h>
+#include <stddef.h>
 
 /***************************************************************************
 *                                CONSTANTS
@@ -64,10 +65,32 @@
 #define CODE_BITS       (DATA_BITS + PARITY_BITS)
 #define CODE_VALUES     (1 << CODE_BITS)
 
+/* minimum Hamming distance between codes and the erasures it can fill */
+#define CODE_DISTANCE   3
+#define MAX_ERASURES    (CODE_DISTANCE - 1)
+
 #if (CODE_BITS > CHAR_BIT)
 #error Encoded data must fit in an unsigned char
 #endif
 
+/* largest output of a stream encode or decode update of len bytes */
+#define HAMMING_STREAM_ENCODE_SIZE(len) \
+    ((((len) * 2 * CODE_BITS) / CHAR_BIT) + 1)
+#define HAMMING_STREAM_DECODE_SIZE(len) \
+    ((((len) * CHAR_BIT) / (2 * CODE_BITS)) + 1)
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+/* state carried between calls for a stream of codes packed into bytes */
+typedef struct
+{
+    unsigned long bits;         /* right justified bits not yet written */
+    unsigned char bitCount;     /* number of bits in bits */
+    unsigned char nibble;       /* decoded MS nibble waiting for LS nibble */
+    unsigned char haveNibble;   /* 1 if nibble is valid */
+} hamming_stream_t;
+
 /***************************************************************************
 *                               PROTOTYPES
 ***************************************************************************/
@@ -80,4 +103,31 @@ unsigned char HammingMatrixDecode(unsigned char code);
 unsigned char HammingTableDecode(unsigned char code);
 unsigned char HammingPackedTableDecode(unsigned char code);
 
+/* encode len bytes into 2 * len codes (MS nibble first) and back */
+void HammingEncodeBuffer(unsigned char *codes, const unsigned char *data,
+    size_t len);
+void HammingDecodeBuffer(unsigned char *data, const unsigned char *codes,
+    size_t len);
+
+/* encode/decode a stream of CODE_BITS long codes packed MSB first */
+void HammingStreamInit(hamming_stream_t *stream);
+size_t HammingStreamEncodeUpdate(hamming_stream_t *stream,
+    unsigned char *packed, const unsigned char *data, size_t len);
+size_t HammingStreamEncodeFinish(hamming_stream_t *stream,
+    unsigned char *packed);
+size_t HammingStreamDecodeUpdate(hamming_stream_t *stream,
+    unsigned char *data, const unsigned char *packed, size_t len);
+int HammingStreamDecodeFinish(hamming_stream_t *stream);
+
+/* compute PARITY_BITS long syndrome of 7 bit Hamming code */
+unsigned char HammingMatrixSyndrome(unsigned char code);
+
+/* decode 7 bit Hamming code with bits marked as erased in erasures */
+int HammingErasureDecode(unsigned char code, unsigned char erasures,
+    unsigned char *data);
+
+/* decode len bytes from 2 * len codes (MS nibble first) and erasure masks */
+size_t HammingErasureDecodeBuffer(unsigned char *data,
+    const unsigned char *codes, const unsigned char *erasures, size_t len);
+
 #endif      /* ndef _HAMMING_H */
@@ -0,0 +1,476 @@
+/***************************************************************************
+*                   Hamming Forward Error Correction Relay
+*
+*   File    : hamrelay.c
+*   Purpose : UDP relay that Hamming encodes (or decodes) every datagram
+*             received on one socket and forwards the result from another.
+*             An encoding relay on one end of a noisy link and a decoding
+*             relay on the other end provide forward error correction for
+*             datagrams without changing the programs that send and
+*             receive them.  Datagrams are received and sent in batches
+*             with recvmmsg and sendmmsg, all buffers are allocated once,
+*             and the buffer versions of the Hamming routines do the
+*             encoding and decoding.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+*
+* Hamrelay: Hamming forward error correction relay for UDP datagrams
+* Copyright (C) 2026 by Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the Hamming library.
+*
+* The Hamming library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The Hamming library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/* recvmmsg and sendmmsg are Linux extensions */
+#define _GNU_SOURCE
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "hamming.h"
+#include "hamrelay.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* number of datagrams received or sent by one system call */
+#define BATCH_SIZE      32
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+typedef enum
+{
+    RELAY_ENCODE,
+    RELAY_DECODE
+} relay_mode_t;
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+/* preallocated datagram buffers, large enough for either direction */
+static unsigned char inBuffers[BATCH_SIZE][MAX_CODED];
+static unsigned char outBuffers[BATCH_SIZE][MAX_CODED];
+
+static struct iovec inIovs[BATCH_SIZE];
+static struct iovec outIovs[BATCH_SIZE];
+static struct mmsghdr inMsgs[BATCH_SIZE];
+static struct mmsghdr outMsgs[BATCH_SIZE];
+
+/* set by signal handler to end the relay loop */
+static volatile sig_atomic_t done = 0;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ShowUsage(const char *name);
+static int ParsePort(const char *str, unsigned short *port);
+static void HandleSignal(int sig);
+static int OpenSockets(unsigned short listenPort, const char *destAddr,
+    unsigned short destPort, int *inSock, int *outSock);
+static void InitMessages(relay_mode_t mode);
+static int Relay(relay_mode_t mode, int inSock, int outSock,
+    const sigset_t *waitMask);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : main
+*   Description: This function is the entry point for the hamrelay
+*                program.  It parses the command line, opens the sockets,
+*                and relays datagrams until it receives SIGINT or SIGTERM.
+*   Parameters : argc - number of command line arguements
+*                argv - command line arguments.
+*                       argv[1][0] == 'E' encode datagrams
+*                       argv[1][0] == 'D' decode datagrams
+*                       argv[2] port to receive datagrams on
+*                       argv[3] IPv4 address to forward datagrams to
+*                       argv[4] port to forward datagrams to
+*   Effects    : Datagrams are relayed.  Counts are written to stderr on
+*                exit.
+*   Returned   : EXIT_SUCCESS when stopped by a signal, otherwise
+*                EXIT_FAILURE.
+***************************************************************************/
+int main(int argc, char *argv[])
+{
+    relay_mode_t mode;
+    unsigned short listenPort, destPort;
+    int inSock, outSock;
+    int result;
+    struct sigaction sa;
+    sigset_t stopSignals, waitMask;
+
+    if (5 != argc)
+    {
+        ShowUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (('e' == argv[1][0]) || ('E' == argv[1][0]))
+    {
+        mode = RELAY_ENCODE;
+    }
+    else if (('d' == argv[1][0]) || ('D' == argv[1][0]))
+    {
+        mode = RELAY_DECODE;
+    }
+    else
+    {
+        ShowUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if ((0 != ParsePort(argv[2], &listenPort)) ||
+        (0 != ParsePort(argv[4], &destPort)))
+    {
+        ShowUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (0 != OpenSockets(listenPort, argv[3], destPort, &inSock, &outSock))
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* no SA_RESTART, so a signal interrupts ppoll */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = HandleSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* only take the signals while waiting, so done can't be missed */
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &stopSignals, &waitMask);
+
+    InitMessages(mode);
+    result = Relay(mode, inSock, outSock, &waitMask);
+
+    close(inSock);
+    close(outSock);
+
+    return result;
+}
+
+/***************************************************************************
+*   Function   : ShowUsage
+*   Description: This function writes the command line usage to stderr.
+*   Parameters : name - name of this program.
+*   Effects    : Usage is written to stderr.
+*   Returned   : None
+***************************************************************************/
+static void ShowUsage(const char *name)
+{
+    fprintf(stderr, "Usage: %s <E|D> <listen port> <dest address> "
+        "<dest port>\n\n", name);
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "    E : Encode received datagrams\n");
+    fprintf(stderr, "    D : Decode received datagrams\n");
+}
+
+/***************************************************************************
+*   Function   : ParsePort
+*   Description: This function converts a decimal string to a UDP port
+*                number.  The whole string must be a number from 1 to
+*                65535.
+*   Parameters : str - string to convert.
+*                port - pointer to where the port number is written.
+*   Effects    : The port number is written to port.  Errors are written
+*                to stderr.
+*   Returned   : 0 for success, otherwise -1.
+***************************************************************************/
+static int ParsePort(const char *str, unsigned short *port)
+{
+    long value;
+    char *end;
+
+    errno = 0;
+    value = strtol(str, &end, 10);
+
+    if ((0 != errno) || (end == str) || ('\0' != *end) ||
+        (value < 1) || (value > 65535))
+    {
+        fprintf(stderr, "Invalid port: %s\n", str);
+        return -1;
+    }
+
+    *port = (unsigned short)value;
+    return 0;
+}
+
+/***************************************************************************
+*   Function   : HandleSignal
+*   Description: This function is the SIGINT and SIGTERM handler.  It
+*                flags the relay loop to stop.
+*   Parameters : sig - signal number (ignored).
+*   Effects    : done is set.
+*   Returned   : None
+***************************************************************************/
+static void HandleSignal(int sig)
+{
+    (void)sig;
+    done = 1;
+}
+
+/***************************************************************************
+*   Function   : OpenSockets
+*   Description: This function opens a UDP socket bound to listenPort on
+*                every interface and a UDP socket connected to
+*                destAddr:destPort.
+*   Parameters : listenPort - port to receive datagrams on.
+*                destAddr - dotted IPv4 address to forward datagrams to.
+*                destPort - port to forward datagrams to.
+*                inSock - pointer to where the receive socket is written.
+*                outSock - pointer to where the send socket is written.
+*   Effects    : Sockets are opened.  Errors are written to stderr.
+*   Returned   : 0 for success, otherwise -1.
+***************************************************************************/
+static int OpenSockets(unsigned short listenPort, const char *destAddr,
+    unsigned short destPort, int *inSock, int *outSock)
+{
+    struct sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(destPort);
+
+    if (1 != inet_pton(AF_INET, destAddr, &addr.sin_addr))
+    {
+        fprintf(stderr, "Invalid destination address: %s\n", destAddr);
+        return -1;
+    }
+
+    *outSock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (*outSock < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+
+    if (0 != connect(*outSock, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+        perror("connect");
+        close(*outSock);
+        return -1;
+    }
+
+    *inSock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (*inSock < 0)
+    {
+        perror("socket");
+        close(*outSock);
+        return -1;
+    }
+
+    addr.sin_port = htons(listenPort);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (0 != bind(*inSock, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+        perror("bind");
+        close(*inSock);
+        close(*outSock);
+        return -1;
+    }
+
+    return 0;
+}
+
+/***************************************************************************
+*   Function   : InitMessages
+*   Description: This function points the recvmmsg and sendmmsg message
+*                headers at the preallocated buffers.  Received datagrams
+*                are limited to the largest size whose result still fits
+*                in a datagram.
+*   Parameters : mode - RELAY_ENCODE or RELAY_DECODE
+*   Effects    : inIovs, outIovs, inMsgs, and outMsgs are initialized.
+*   Returned   : None
+***************************************************************************/
+static void InitMessages(relay_mode_t mode)
+{
+    int i;
+
+    memset(inMsgs, 0, sizeof(inMsgs));
+    memset(outMsgs, 0, sizeof(outMsgs));
+
+    for (i = 0; i < BATCH_SIZE; i++)
+    {
+        inIovs[i].iov_base = inBuffers[i];
+        inIovs[i].iov_len = (RELAY_ENCODE == mode) ? MAX_DATA : MAX_CODED;
+        inMsgs[i].msg_hdr.msg_iov = &inIovs[i];
+        inMsgs[i].msg_hdr.msg_iovlen = 1;
+
+        outIovs[i].iov_base = outBuffers[i];
+        outMsgs[i].msg_hdr.msg_iov = &outIovs[i];
+        outMsgs[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+/***************************************************************************
+*   Function   : Relay
+*   Description: This function receives batches of datagrams on inSock,
+*                encodes or decodes each of them, and sends the batch of
+*                results out of outSock.  Datagrams that were truncated,
+*                or that are not an even number of codes when decoding,
+*                are dropped.  If a send fails for any reason other than a
+*                broken socket, the rest of the batch is dropped.
+*                SIGINT and SIGTERM must be blocked by the caller.  They
+*                are only unblocked while waiting for datagrams, so a
+*                signal can't slip in between testing done and waiting.
+*   Parameters : mode - RELAY_ENCODE or RELAY_DECODE
+*                inSock - bound socket to receive datagrams on.
+*                outSock - connected socket to send datagrams from.
+*                waitMask - signal mask to use while waiting.
+*   Effects    : Datagrams are relayed until done is set.  Counts are
+*                written to stderr on exit.
+*   Returned   : EXIT_SUCCESS when stopped by a signal, otherwise
+*                EXIT_FAILURE.
+***************************************************************************/
+static int Relay(relay_mode_t mode, int inSock, int outSock,
+    const sigset_t *waitMask)
+{
+    int received, sent, result;
+    int i, count;
+    size_t len;
+    unsigned long relayed, dropped;
+    struct pollfd pfd;
+
+    relayed = 0;
+    dropped = 0;
+    result = EXIT_SUCCESS;
+    pfd.fd = inSock;
+    pfd.events = POLLIN;
+
+    while (!done)
+    {
+        /* wait for the first datagram with the stop signals unblocked */
+        if (ppoll(&pfd, 1, NULL, waitMask) < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            perror("ppoll");
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        /* take whatever is queued without blocking */
+        received = recvmmsg(inSock, inMsgs, BATCH_SIZE, MSG_DONTWAIT,
+            NULL);
+
+        if (received < 0)
+        {
+            if ((EINTR == errno) || (EAGAIN == errno) ||
+                (EWOULDBLOCK == errno))
+            {
+                continue;
+            }
+
+            perror("recvmmsg");
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        count = 0;
+
+        for (i = 0; i < received; i++)
+        {
+            len = inMsgs[i].msg_len;
+
+            if (inMsgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                dropped++;
+                continue;
+            }
+
+            if (RELAY_ENCODE == mode)
+            {
+                HammingEncodeBuffer(outBuffers[count], inBuffers[i], len);
+                outIovs[count].iov_len = 2 * len;
+            }
+            else
+            {
+                if (len % 2)
+                {
+                    dropped++;
+                    continue;
+                }
+
+                HammingDecodeBuffer(outBuffers[count], inBuffers[i],
+                    len / 2);
+                outIovs[count].iov_len = len / 2;
+            }
+
+            count++;
+        }
+
+        for (sent = 0; sent < count;)
+        {
+            i = sendmmsg(outSock, &outMsgs[sent], count - sent, 0);
+
+            if (i < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+
+                /* only a broken socket stops the relay */
+                if ((EBADF == errno) || (ENOTSOCK == errno))
+                {
+                    perror("sendmmsg");
+                    result = EXIT_FAILURE;
+                    done = 1;
+                }
+
+                /* ICMP errors from earlier sends and full buffers are */
+                /* routine on a noisy link, so just drop rest of batch */
+                break;
+            }
+
+            sent += i;
+        }
+
+        relayed += sent;
+        dropped += count - sent;
+    }
+
+    fprintf(stderr, "%s: %lu datagrams relayed, %lu dropped\n",
+        (RELAY_ENCODE == mode) ? "encoder" : "decoder", relayed, dropped);
+
+    return result;
+}
@@ -0,0 +1,42 @@
+/***************************************************************************
+*               Hamming Forward Error Correction Relay Header
+*
+*   File    : hamrelay.h
+*   Purpose : Header for the Hamming forward error correction relay.
+*             Contains the datagram size limits shared by the relay and
+*             its loopback test.
+*   Author  : Michael Dipperstein
+*   Date    : October 19, 2026
+*
+****************************************************************************
+*
+* Hamrelay: Hamming forward error correction relay for UDP datagrams
+* Copyright (C) 2026 by Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the Hamming library.
+*
+* The Hamming library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The Hamming library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+#ifndef _HAMRELAY_H
+#define _HAMRELAY_H
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+/* largest UDP payload, encoded datagrams are twice the size of the data */
+#define MAX_CODED       65506
+#define MAX_DATA        (MAX_CODED / 2)
+
+#endif      /* ndef _HAMRELAY_H */
@@ -60,14 +60,17 @@
 *                             INCLUDED FILES
 ***************************************************************************/
 #include <stdio.h>
+#include <string.h>
 #include "hamming.h"
 
 /***************************************************************************
 *                               PROTOTYPES
 ***************************************************************************/
 void TestAll(void);
+void TestStreams(void);
 void BuildCodeTable(void);
 void BuildDecodeTables(void);
+unsigned char CountBits(unsigned char bits);
 
 /***************************************************************************
 *                                FUNCTIONS
@@ -113,6 +116,7 @@ int main(int argc, char *argv[])
 
     /* test every function */
     TestAll();
+    TestStreams();
 
     return 0;
 }
@@ -134,7 +138,11 @@ void TestAll(void)
 {
     unsigned char testValue;
     unsigned char result1, result2, result3;
-    unsigned char error;
+    unsigned char error, erasures;
+    unsigned char codes[2 * DATA_VALUES], masks[2 * DATA_VALUES];
+    unsigned char decoded[DATA_VALUES];
+    int resolved;
+    size_t unresolved;
 
     /* verify that decode is the reverse of encode */
     printf("Verifying Matched Encode/Decode ...\n");
@@ -207,6 +215,242 @@ void TestAll(void)
                 testValue, result1, result2, result3);
         }
     }
+
+    /* verify that buffer encode/decode match the single value versions */
+    printf("\nVerifying Buffer Encode/Decode ...\n");
+    for (testValue = 0x00; testValue < DATA_VALUES; testValue++)
+    {
+        /* every byte whose nibbles differ by testValue */
+        for (error = 0x00; error < DATA_VALUES; error++)
+        {
+            decoded[error] = (error << DATA_BITS) | (error ^ testValue);
+        }
+
+        HammingEncodeBuffer(codes, decoded, DATA_VALUES);
+
+        for (error = 0x00; error < DATA_VALUES; error++)
+        {
+            if ((codes[2 * error] != HammingTableEncode(error)) ||
+                (codes[2 * error + 1] !=
+                    HammingTableEncode(error ^ testValue)))
+            {
+                printf("*** Error Encoding: %02X ****\n", decoded[error]);
+            }
+
+            /* flip a different bit in each code */
+            codes[2 * error] ^= 0x01 << (error % CODE_BITS);
+            codes[2 * error + 1] ^= 0x01 << (testValue % CODE_BITS);
+        }
+
+        HammingDecodeBuffer(decoded, codes, DATA_VALUES);
+
+        for (error = 0x00; error < DATA_VALUES; error++)
+        {
+            if (decoded[error] != ((error << DATA_BITS) | (error ^ testValue)))
+            {
+                printf("*** Error Decoding: %02X %02X ****\n",
+                    codes[2 * error], codes[2 * error + 1]);
+            }
+        }
+    }
+
+    /* verify that erasures (with their bits flipped) are filled */
+    printf("\nVerifying Erasures Are Filled ...\n");
+    printf("Value\tEncoded\tErased\tError\tDecoded\n");
+    for (testValue = 0x00; testValue < DATA_VALUES; testValue++)
+    {
+        result1 = HammingMatrixEncode(testValue);
+
+        for (erasures = 0x00; erasures < CODE_VALUES; erasures++)
+        {
+            result2 = result1 ^ erasures;
+            resolved = HammingErasureDecode(result2, erasures, &result3);
+
+            if (CountBits(erasures) > MAX_ERASURES)
+            {
+                if (resolved)
+                {
+                    printf("*** Error Resolving: %02X %02X ****\n",
+                        result2, erasures);
+                }
+
+                continue;
+            }
+
+            if (!resolved || (testValue != result3))
+            {
+                printf("*** Error Decoding: %02X %02X ****\n",
+                    result2, erasures);
+            }
+
+            printf("%02X\t%02X\t%02X\t%02X\t%02X\n",
+                testValue, result1, erasures, result2, result3);
+        }
+    }
+
+    /* verify that buffer decode resolves erasures and counts failures */
+    printf("\nVerifying Erasure Buffer Decode ...\n");
+    for (testValue = 0x00; testValue < DATA_VALUES; testValue++)
+    {
+        /* byte testValue * 0x11 - 1 exercises both nibbles */
+        result1 = (testValue * 0x11) - 1;
+        codes[2 * testValue] = HammingTableEncode(result1 >> DATA_BITS);
+        codes[2 * testValue + 1] = HammingTableEncode(result1 & 0x0F);
+
+        /* erase and flip two bits of the MS nibble, one of the LS nibble */
+        masks[2 * testValue] = 0x03 << (testValue % (CODE_BITS - 1));
+        masks[2 * testValue + 1] = 0x01 << (testValue % CODE_BITS);
+        codes[2 * testValue] ^= masks[2 * testValue];
+        codes[2 * testValue + 1] ^= masks[2 * testValue + 1];
+    }
+
+    unresolved = HammingErasureDecodeBuffer(decoded, codes, masks,
+        DATA_VALUES);
+
+    for (testValue = 0x00; testValue < DATA_VALUES; testValue++)
+    {
+        result1 = (testValue * 0x11) - 1;
+
+        if (decoded[testValue] != result1)
+        {
+            printf("*** Error Decoding: %02X ****\n", result1);
+        }
+    }
+
+    if (0 != unresolved)
+    {
+        printf("*** Error: %u Unresolved ****\n", (unsigned)unresolved);
+    }
+
+    /* three erasures can't be resolved */
+    masks[0] = 0x07;
+    unresolved = HammingErasureDecodeBuffer(decoded, codes, masks, 1);
+
+    if (1 != unresolved)
+    {
+        printf("*** Error: %u Unresolved ****\n", (unsigned)unresolved);
+    }
+}
+
+/***************************************************************************
+*   Function   : TestStreams
+*   Description: This function verifies that encoding a buffer with the
+*                stream functions produces the same packed codes whether
+*                the buffer is passed in one chunk or many smaller chunks
+*                of every size, and that the packed codes decode back to
+*                the buffer, in chunks of every size, even with a bit
+*                error in every code.  Any error that may occur is written
+*                to stdout.
+*   Parameters : None
+*   Effects    : Results of verify are written to stdout
+*   Returned   : None
+***************************************************************************/
+void TestStreams(void)
+{
+    hamming_stream_t stream;
+    unsigned char data[UCHAR_MAX + 1];
+    unsigned char packed[HAMMING_STREAM_ENCODE_SIZE(UCHAR_MAX + 1)];
+    unsigned char chunked[HAMMING_STREAM_ENCODE_SIZE(UCHAR_MAX + 1)];
+    unsigned char decoded[HAMMING_STREAM_DECODE_SIZE(sizeof(packed))];
+    size_t i, chunk, len, packedLen, chunkedLen, decodedLen;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (unsigned char)i;
+    }
+
+    /* one chunk is the reference */
+    HammingStreamInit(&stream);
+    packedLen = HammingStreamEncodeUpdate(&stream, packed, data,
+        sizeof(data));
+    packedLen += HammingStreamEncodeFinish(&stream, packed + packedLen);
+
+    /* codes for 0x00 and 0x01 are 0 0 0 code(1), so 21 zero bits */
+    if ((packedLen != ((sizeof(data) * 2 * CODE_BITS) + CHAR_BIT - 1) /
+        CHAR_BIT) || (0x00 != packed[0]) || (0x00 != packed[1]) ||
+        ((HammingTableEncode(0x01) >> 4) != packed[2]))
+    {
+        printf("*** Error Packing Stream ****\n");
+    }
+
+    printf("\nVerifying Chunked Streams ...\n");
+    printf("Chunk\tEncoded\tDecoded\n");
+    for (chunk = 1; chunk <= 2 * CODE_BITS; chunk++)
+    {
+        HammingStreamInit(&stream);
+        chunkedLen = 0;
+
+        for (i = 0; i < sizeof(data); i += len)
+        {
+            len = (sizeof(data) - i < chunk) ? sizeof(data) - i : chunk;
+            chunkedLen += HammingStreamEncodeUpdate(&stream,
+                chunked + chunkedLen, data + i, len);
+        }
+
+        chunkedLen += HammingStreamEncodeFinish(&stream,
+            chunked + chunkedLen);
+
+        if ((chunkedLen != packedLen) ||
+            (0 != memcmp(chunked, packed, packedLen)))
+        {
+            printf("*** Error Encoding: chunk %u ****\n", (unsigned)chunk);
+        }
+
+        /* flip a bit in every code before decoding */
+        for (i = 0; i < (2 * sizeof(data)); i++)
+        {
+            len = (i * CODE_BITS) + ((i + chunk) % CODE_BITS);
+            chunked[len / CHAR_BIT] ^= 0x80 >> (len % CHAR_BIT);
+        }
+
+        decodedLen = 0;
+
+        for (i = 0; i < chunkedLen; i += len)
+        {
+            len = (chunkedLen - i < chunk) ? chunkedLen - i : chunk;
+            decodedLen += HammingStreamDecodeUpdate(&stream,
+                decoded + decodedLen, chunked + i, len);
+        }
+
+        if (!HammingStreamDecodeFinish(&stream) ||
+            (decodedLen != sizeof(data)) ||
+            (0 != memcmp(decoded, data, sizeof(data))))
+        {
+            printf("*** Error Decoding: chunk %u ****\n", (unsigned)chunk);
+        }
+
+        printf("%u\t%u\t%u\n", (unsigned)chunk, (unsigned)chunkedLen,
+            (unsigned)decodedLen);
+    }
+
+    /* a stream cut off after a lone code is incomplete */
+    HammingStreamInit(&stream);
+    HammingStreamDecodeUpdate(&stream, decoded, packed, 1);
+
+    if (HammingStreamDecodeFinish(&stream))
+    {
+        printf("*** Error: truncated stream not detected ****\n");
+    }
+}
+
+/***************************************************************************
+*   Function   : CountBits
+*   Description: This function counts the bits set to 1 in an unsigned
+*                char.
+*   Parameters : bits - bits to be counted.
+*   Effects    : None
+*   Returned   : Number of bits set to 1.
+***************************************************************************/
+unsigned char CountBits(unsigned char bits)
+{
+    unsigned char count;
+
+    for (count = 0; bits; bits &= (bits - 1))
+    {
+        count++;
+    }
+
+    return count;
 }
 
 /***************************************************************************
@@ -239,14 +483,15 @@ void BuildCodeTable(void)
 
 /***************************************************************************
 *   Function   : BuildDecodeTables
-*   Description: This function uses HammingMatrixDecode to output text
-*                suitable to be used for replacing the arrays
-*                hammingDecodeValues and hammingPackedDecodeValues in
+*   Description: This function uses HammingMatrixDecode and
+*                HammingMatrixSyndrome to output text suitable to be used
+*                for replacing the arrays hammingDecodeValues,
+*                hammingPackedDecodeValues, and hammingSyndromes in
 *                hamming.c.
 *   Parameters : None
 *   Effects    : Tables in format sutibale for replacing
-*                hammingDecodeValues and hammingPackedDecodeValues in
-*                hamming.c are written to stdout.
+*                hammingDecodeValues, hammingPackedDecodeValues, and
+*                hammingSyndromes in hamming.c are written to stdout.
 *   Returned   : None
 ***************************************************************************/
 void BuildDecodeTables(void)
@@ -295,4 +540,22 @@ void BuildDecodeTables(void)
 
     result = HammingMatrixDecode(value);
     printf("%1X      /* 0x%02X to 0x%02X */\n};\n", result, (value - 7), value);
+
+    printf("\nDumping Syndrome Table ...\n");
+    printf("const unsigned char hammingSyndromes[CODE_VALUES] =\n");
+    printf("{\n    ");
+    for (value = 0x00; value < (CODE_VALUES - 1); value++)
+    {
+        result = HammingMatrixSyndrome(value);
+        printf("0x%02X, ", result);
+
+        if (7 == (value % 8))
+        {
+            printf("    /* 0x%02X to 0x%02X */\n    ", (value - 7), value);
+        }
+    }
+
+    result = HammingMatrixSyndrome(value);
+    printf("0x%02X      /* 0x%02X to 0x%02X */\n};\n",
+        result, (value - 7), value);
 }
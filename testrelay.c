@@ -0,0 +1,440 @@
+/***************************************************************************
+*               Hamming Forward Error Correction Relay Test
+*
+*   File    : testrelay.c
+*   Purpose : Loopback test for the hamrelay program.  This program starts
+*             an encoding relay and a decoding relay and stands in for the
+*             noisy link between them.  Datagrams sent to the encoding
+*             relay are checked against HammingEncodeBuffer, have a bit
+*             flipped in every code, and are passed to the decoding relay.
+*             The datagrams leaving the decoding relay must match the
+*             datagrams that were sent.
+*   Author  : Michael Dipperstein
+*   Date    : October 18, 2026
+*
+****************************************************************************
+*
+* Testrelay: Loopback test for the Hamming forward error correction relay
+* Copyright (C) 2026 by Michael Dipperstein (mdipperstein@gmail.com)
+*
+* This file is part of the Hamming library.
+*
+* The Hamming library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public License as
+* published by the Free Software Foundation; either version 3 of the
+* License, or (at your option) any later version.
+*
+* The Hamming library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+* General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+***************************************************************************/
+
+/* sockets and processes are POSIX, not ANSI */
+#define _POSIX_C_SOURCE 200112L
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "hamming.h"
+#include "hamrelay.h"
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+#define DEFAULT_PORT    47000   /* relays use the next 4 ports */
+#define RELAY_PATH      "./hamrelay"
+
+#define BURST_SIZE      16      /* datagrams in flight at once */
+#define BURSTS          6       /* burst n has datagrams up to 64 << n */
+#define RETRIES         50      /* 100ms receive timeouts while starting */
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+static unsigned char sentData[BURST_SIZE][MAX_DATA];
+static size_t sentLen[BURST_SIZE];
+static unsigned char codes[2 * MAX_DATA];
+static unsigned char expected[2 * MAX_DATA];
+static unsigned char received[2 * MAX_DATA + 1];
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static pid_t StartRelay(const char *mode, unsigned short listenPort,
+    unsigned short destPort);
+static int OpenSocket(unsigned short port);
+static void SetAddress(struct sockaddr_in *addr, unsigned short port);
+static int SendAndWait(int sendSock, const struct sockaddr_in *dest,
+    int recvSock);
+static void Drain(int sock);
+static int RunBurst(int txSock, int linkSock, int rxSock,
+    const struct sockaddr_in *encoder, const struct sockaddr_in *decoder,
+    int count, size_t maxLen);
+static int TestOddLength(int linkSock, int rxSock,
+    const struct sockaddr_in *decoder);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/***************************************************************************
+*   Function   : main
+*   Description: This function is the entry point for the testrelay
+*                program.  It opens the sockets for the test, starts both
+*                relays, waits for them to pass a datagram, and then runs
+*                bursts of datagrams through them.
+*   Parameters : argc - number of command line arguements
+*                argv - command line arguments.
+*                       argv[1] optional base port (default 47000)
+*   Effects    : Results of test are written to stdout
+*   Returned   : EXIT_SUCCESS if all datagrams are relayed correctly,
+*                otherwise EXIT_FAILURE.
+***************************************************************************/
+int main(int argc, char *argv[])
+{
+    unsigned short port;
+    int txSock, linkSock, rxSock;
+    struct sockaddr_in encoder, decoder;
+    pid_t encoderPid, decoderPid;
+    int i, errors;
+
+    port = (2 == argc) ? (unsigned short)atoi(argv[1]) : DEFAULT_PORT;
+
+    /* encoder: port + 1 -> port + 2, decoder: port + 3 -> port + 4 */
+    SetAddress(&encoder, port + 1);
+    SetAddress(&decoder, port + 3);
+
+    txSock = OpenSocket(0);
+    linkSock = OpenSocket(port + 2);
+    rxSock = OpenSocket(port + 4);
+
+    if ((txSock < 0) || (linkSock < 0) || (rxSock < 0))
+    {
+        return EXIT_FAILURE;
+    }
+
+    encoderPid = StartRelay("E", port + 1, port + 2);
+    decoderPid = StartRelay("D", port + 3, port + 4);
+    errors = 0;
+
+    printf("Waiting For Relays ...\n");
+    if ((encoderPid < 0) || (decoderPid < 0) ||
+        (0 != SendAndWait(txSock, &encoder, linkSock)) ||
+        (0 != SendAndWait(linkSock, &decoder, rxSock)))
+    {
+        printf("*** Error Starting Relays ****\n");
+        errors++;
+    }
+    else
+    {
+        Drain(linkSock);
+        Drain(rxSock);
+
+        printf("Verifying Bursts Of Datagrams ...\n");
+        printf("Burst\tCount\tErrors\n");
+        for (i = 0; i < BURSTS; i++)
+        {
+            errors += RunBurst(txSock, linkSock, rxSock, &encoder, &decoder,
+                BURST_SIZE, 64 << i);
+        }
+
+        printf("Verifying Largest Datagram ...\n");
+        errors += RunBurst(txSock, linkSock, rxSock, &encoder, &decoder,
+            1, MAX_DATA);
+
+        printf("Verifying Odd Length Code Is Dropped ...\n");
+        errors += TestOddLength(linkSock, rxSock, &decoder);
+    }
+
+    if (encoderPid > 0)
+    {
+        kill(encoderPid, SIGTERM);
+        waitpid(encoderPid, NULL, 0);
+    }
+
+    if (decoderPid > 0)
+    {
+        kill(decoderPid, SIGTERM);
+        waitpid(decoderPid, NULL, 0);
+    }
+
+    close(txSock);
+    close(linkSock);
+    close(rxSock);
+
+    printf("%d errors\n", errors);
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***************************************************************************
+*   Function   : StartRelay
+*   Description: This function forks and executes a hamrelay relaying
+*                from listenPort to destPort on the loopback interface.
+*   Parameters : mode - "E" for an encoding relay or "D" for decoding.
+*                listenPort - port the relay receives datagrams on.
+*                destPort - port the relay forwards datagrams to.
+*   Effects    : A relay process is started.
+*   Returned   : Process ID of relay, or -1 on failure.
+***************************************************************************/
+static pid_t StartRelay(const char *mode, unsigned short listenPort,
+    unsigned short destPort)
+{
+    pid_t pid;
+    char listenStr[8], destStr[8];
+
+    sprintf(listenStr, "%u", listenPort);
+    sprintf(destStr, "%u", destPort);
+
+    pid = fork();
+
+    if (0 == pid)
+    {
+        execl(RELAY_PATH, RELAY_PATH, mode, listenStr, "127.0.0.1", destStr,
+            (char *)NULL);
+        perror(RELAY_PATH);
+        _exit(EXIT_FAILURE);
+    }
+    else if (pid < 0)
+    {
+        perror("fork");
+    }
+
+    return pid;
+}
+
+/***************************************************************************
+*   Function   : OpenSocket
+*   Description: This function opens a UDP socket on the loopback
+*                interface with a 100ms receive timeout.
+*   Parameters : port - port to bind the socket to (0 for any port).
+*   Effects    : A socket is opened.  Errors are written to stderr.
+*   Returned   : Socket, or -1 on failure.
+***************************************************************************/
+static int OpenSocket(unsigned short port)
+{
+    int sock;
+    struct sockaddr_in addr;
+    struct timeval timeout;
+
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (sock < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 100000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    SetAddress(&addr, port);
+
+    if (0 != bind(sock, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+        perror("bind");
+        close(sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+/***************************************************************************
+*   Function   : SetAddress
+*   Description: This function sets a socket address to a port on the
+*                loopback interface.
+*   Parameters : addr - pointer to address to be set.
+*                port - port number.
+*   Effects    : addr is set.
+*   Returned   : None
+***************************************************************************/
+static void SetAddress(struct sockaddr_in *addr, unsigned short port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+/***************************************************************************
+*   Function   : SendAndWait
+*   Description: This function repeatedly sends an empty datagram to a
+*                relay that may still be starting, until something comes
+*                out the other side.
+*   Parameters : sendSock - socket to send from.
+*                dest - address of relay.
+*                recvSock - socket the relay forwards to.
+*   Effects    : Datagrams are sent and received.
+*   Returned   : 0 if a datagram came through, otherwise -1.
+***************************************************************************/
+static int SendAndWait(int sendSock, const struct sockaddr_in *dest,
+    int recvSock)
+{
+    int i;
+
+    for (i = 0; i < RETRIES; i++)
+    {
+        sendto(sendSock, received, 0, 0, (const struct sockaddr *)dest,
+            sizeof(*dest));
+
+        if (recv(recvSock, received, sizeof(received), 0) >= 0)
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/***************************************************************************
+*   Function   : Drain
+*   Description: This function discards datagrams queued on a socket until
+*                a receive times out.
+*   Parameters : sock - socket to drain.
+*   Effects    : Queued datagrams are discarded.
+*   Returned   : None
+***************************************************************************/
+static void Drain(int sock)
+{
+    while (recv(sock, received, sizeof(received), 0) >= 0)
+    {
+        /* discard */
+    }
+}
+
+/***************************************************************************
+*   Function   : RunBurst
+*   Description: This function sends count datagrams of pseudo-random
+*                length and content to the encoding relay.  It verifies
+*                each encoded datagram, flips one bit in every code, and
+*                forwards it to the decoding relay.  Finally it verifies
+*                that each decoded datagram matches what was sent.
+*   Parameters : txSock - socket to send original datagrams from.
+*                linkSock - socket receiving encoded datagrams.
+*                rxSock - socket receiving decoded datagrams.
+*                encoder - address of encoding relay.
+*                decoder - address of decoding relay.
+*                count - number of datagrams (up to BURST_SIZE).
+*                maxLen - largest datagram length (up to MAX_DATA).
+*   Effects    : Results of test are written to stdout
+*   Returned   : Number of errors
+***************************************************************************/
+static int RunBurst(int txSock, int linkSock, int rxSock,
+    const struct sockaddr_in *encoder, const struct sockaddr_in *decoder,
+    int count, size_t maxLen)
+{
+    static unsigned burst = 0;
+    int i, errors, forwarded;
+    int order[BURST_SIZE];
+    size_t j;
+    ssize_t len;
+
+    errors = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        sentLen[i] = (count > 1) ? 1 + (rand() % maxLen) : maxLen;
+
+        for (j = 0; j < sentLen[i]; j++)
+        {
+            sentData[i][j] = rand();
+        }
+
+        sendto(txSock, sentData[i], sentLen[i], 0,
+            (const struct sockaddr *)encoder, sizeof(*encoder));
+    }
+
+    /* the link: verify the codes and corrupt them */
+    forwarded = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        len = recv(linkSock, codes, sizeof(codes), 0);
+        HammingEncodeBuffer(expected, sentData[i], sentLen[i]);
+
+        if ((len != (ssize_t)(2 * sentLen[i])) ||
+            (0 != memcmp(codes, expected, len)))
+        {
+            printf("*** Error Encoding: datagram %d ****\n", i);
+            errors++;
+            continue;
+        }
+
+        for (j = 0; j < (size_t)len; j++)
+        {
+            codes[j] ^= 0x01 << (rand() % CODE_BITS);
+        }
+
+        sendto(linkSock, codes, len, 0, (const struct sockaddr *)decoder,
+            sizeof(*decoder));
+        order[forwarded++] = i;
+    }
+
+    for (i = 0; i < forwarded; i++)
+    {
+        len = recv(rxSock, received, sizeof(received), 0);
+
+        if ((len != (ssize_t)sentLen[order[i]]) ||
+            (0 != memcmp(received, sentData[order[i]], len)))
+        {
+            printf("*** Error Decoding: datagram %d ****\n", order[i]);
+            errors++;
+        }
+    }
+
+    printf("%u\t%d\t%d\n", burst++, count, errors);
+    return errors;
+}
+
+/***************************************************************************
+*   Function   : TestOddLength
+*   Description: This function sends the decoding relay a datagram with
+*                an odd number of codes followed by a valid datagram.  Only
+*                the valid datagram should be decoded.
+*   Parameters : linkSock - socket to send encoded datagrams from.
+*                rxSock - socket receiving decoded datagrams.
+*                decoder - address of decoding relay.
+*   Effects    : Results of test are written to stdout
+*   Returned   : Number of errors
+***************************************************************************/
+static int TestOddLength(int linkSock, int rxSock,
+    const struct sockaddr_in *decoder)
+{
+    ssize_t len;
+
+    codes[0] = HammingTableEncode(0x0A);
+    codes[1] = HammingTableEncode(0x05);
+    codes[2] = HammingTableEncode(0x0F);
+
+    sendto(linkSock, codes, 3, 0, (const struct sockaddr *)decoder,
+        sizeof(*decoder));
+    sendto(linkSock, codes, 2, 0, (const struct sockaddr *)decoder,
+        sizeof(*decoder));
+
+    len = recv(rxSock, received, sizeof(received), 0);
+
+    if ((1 != len) || (0xA5 != received[0]))
+    {
+        printf("*** Error: odd length datagram relayed ****\n");
+        return 1;
+    }
+
+    return 0;
+}